@@ -11,37 +11,75 @@
 
 #define TRUE	1
 #include <stddef.h>
+#include <pthread.h>
 #define FALSE	0
 
+#define ZGT_WFG_SIZE      1024   //buckets of the tid -> node table (power of 2)
+#define ZGT_DDLOCK_PERIOD 100    //default detector period in ms; 0 disables it
+#define ZGT_DDLOCK_PROBE  256    //edges a new waiter's own cycle check may look at
 
+class zgt_tx;
+struct node;
+struct zgt_logrec;
 
+// an edge tid -> to->tid of the wait-for graph; kept on the waiter's out
+// list and on the holder's in list so either end can drop it
+struct edge {
+	node*	from;
+	node*	to;
+	edge*	next_out;
+	edge*	next_in;
+};
+
+// one vertex per transaction that waits or is waited on. The graph is kept
+// up to date by the lock table: edges are added when a request is queued
+// and dropped when it is granted or cancelled, and a node goes away when
+// its transaction commits or aborts.
 struct node {
 	long tid;
-	long sgno;
-	long obno;
-	char lockmode;
-	int semno;
-	int level;
-	node*	next;
-	node*	next_s;
-	node*	parent;
+	zgt_tx *tx;	//valid while the node is in the graph
+	edge*	out;	//transactions this one waits for
+	edge*	in;	//transactions waiting for this one
+	int	level;	//dfs path depth, -1 when not on the path
+	long	stamp;	//pass in which the node was last visited
+	int	dirty;	//gained an out edge since the last pass
+	node*	next;	//hash chain
+	node*	next_s;	//dirty list
+	node*	parent;	//dfs predecessor: the search path, back to its root
+	edge*	cur;	//dfs: next out edge to follow
 };
 
 
 
 class wait_for {
 
-	node*	head;
-	node*	wtable;
-	int	found;
+	node*	wtable[ZGT_WFG_SIZE];
+	node*	head;	//dirty list: roots of the next pass
+	int	found;	//cycles found in the current pass
 	node*	victim;
+	long	pass;
+	int	do_abort;
+	node*	adding;	//the waiter between begin_edges and end_edges
+	zgt_logrec*	recs;	//log group of the cycle being reported
+	int	reccap;
+	pthread_mutex_t	glock;	//protects the whole graph
 
-	int visited(long);
 	node* location(long);
+	node* get_node(zgt_tx *);
+	void drop_out(node *);
 	int traverse(node *);
+	void log_cycle(node *, node *);
+	int probe(node *);
 	node* choose_victim(node *, node *);
+	void kill(node *);
 	public:
-	int deadlock();
+	void begin_edges(zgt_tx *);	//latch the graph for a new waiter
+	void add_edge(zgt_tx *, zgt_tx *);	//waiter waits for holder
+	int end_edges();	//unlatch; TRUE if the waiter may have closed a cycle
+	void clear_wait(long);	//waiter was granted or gave up
+	void drop_edge(zgt_tx *, zgt_tx *);	//waiter no longer waits for holder
+	void remove(long);	//tx ended: drop its node and every edge
+	int deadlock(int);	//one detection pass; aborts victims if asked
 	wait_for();
-	~wait_for(){};
+	~wait_for();
 };
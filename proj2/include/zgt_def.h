@@ -31,12 +31,64 @@
 #define DEFAULT_INTERVAL 5
 */
 
-#define  ZGT_DEFAULT_HASH_TABLE_SIZE  13
+// lock table sizing; the size is always rounded up to a power of two so
+// hashing() can mask instead of divide. The table doubles when a bucket
+// chain gets longer than ZGT_HT_MAX_CHAIN and the table is loaded past
+// ZGT_HT_LOAD_FACTOR entries per bucket.
+#define  ZGT_DEFAULT_HASH_TABLE_SIZE  64
+#define  ZGT_HT_MAX_CHAIN             8
+#define  ZGT_HT_LOAD_FACTOR           2
+
+#define  ZGT_CACHE_LINE               64
 
 #define NTRANSACTION_TYPES 2
 #define ODD 1
 
 
+// zgt_ht::lock results
+#define ZGT_LOCK_GRANTED 0
+#define ZGT_LOCK_WAIT    1
+#define ZGT_LOCK_DENIED  2   // the conflict policy aborts the requester
+
+// lock modes (zgt_hlink::lockmode). Objects are locked S or X. With
+// segments on, the segment above is locked IS or IX first, and S, SIX or
+// X once the tx's object locks under it are escalated.
+#define ZGT_IS    'i'
+#define ZGT_IX    'x'
+#define ZGT_S     'S'
+#define ZGT_SIX   'y'
+#define ZGT_X     'X'
+#define ZGT_NMODES 5
+
+#define ZGT_SEGMENT   -1L    // obno of the lock entry of a segment itself
+#define ZGT_SEG_SIZE  1024   // default objects per segment; 0: object locks only
+#define ZGT_ESCALATE  64     // default object locks a tx holds in a segment
+                             // before they become one segment lock; 0: never
+
+// lock conflict policies, picked when the zgt_tm is constructed. Ages come
+// from zgt_tx::ts, the order in which transactions began.
+#define ZGT_DETECT      0    // wait; the deadlock detector breaks cycles
+#define ZGT_WAIT_DIE    1    // older waits for younger, younger aborts
+#define ZGT_WOUND_WAIT  2    // older aborts younger holders, younger waits
+#define ZGT_NO_WAIT     3    // any conflict aborts the requester
+#define ZGT_TIMEOUT     4    // wait at most locktimeout ms, then abort
+
+#define ZGT_LOCK_TIMEOUT 1000   // default locktimeout in ms
+#define ZGT_TIMEOUT_TICKS 10    // timed out waits are looked for this often per locktimeout
+
+// why a tx was aborted (zgt_tx::abortwhy, ZGT_LOG_ABORT records)
+#define ZGT_WHY_USER      0    // AbortTx in the schedule; not set on a tx
+#define ZGT_WHY_LOCKMGR   1    // lock manager, no more specific reason
+#define ZGT_WHY_DEADLOCK  2    // deadlock victim
+#define ZGT_WHY_WAIT_DIE  3
+#define ZGT_WHY_WOUNDED   4
+#define ZGT_WHY_NO_WAIT   5
+#define ZGT_WHY_TIMEOUT   6
+#define ZGT_WHY_END       7    // still active when the schedule ended
+#define ZGT_WHY_RECOVERY  8    // in flight at a crash; undone at restart
+#define ZGT_WHY_LOGFAIL   9    // its commit record could not be made durable
+#define ZGT_WHY_COUNT     10   // reasons above
+
 #define TR_ACTIVE 'P'
 #define TR_WAIT   'W'
 #define TR_ABORT  'A'
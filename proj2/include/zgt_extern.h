@@ -14,16 +14,9 @@ extern  void *readtx(void *);
 extern  void *writetx(void *);
 extern  void *aborttx(void *);
 extern  void *committx(void *);
+extern  void *endtx(void *);
 extern  zgt_tx* get_tx(long);
-extern  int zgt_init_sema(int);
-extern void  zgt_init_sema_0(int);
-extern void  zgt_init_sema_rest(int);
-extern int   zgt_sem_release(int);//added 2014
-
-extern int  zgt_p(int);
-extern int  zgt_v(int);
-extern int  zgt_nwait(int);
-//extern int zgt_nwait1(int);
+
 //extern void  exit(int);
 
 extern zgt_ht *ZGT_Ht;
@@ -34,19 +27,11 @@ extern zgt_tx *ZGT_Tx;
 extern int errno;
 
 
-extern key_t ZGT_Key_sem;
-extern int ZGT_Semid ;
-extern int ZGT_Nsema ;
 
 extern int system(char *);
 extern int ZGT_Initp;
 extern int Zgt_errno;
 
-struct param
-{
-  long tid, obno, count;
-  char Txtype;
-};
 
 
 
@@ -12,19 +12,25 @@
 /* The main data structures used in this project: */
 // ZGT_Ht -- hash table data structure
 // ZGT_Sh  -- main tx manager data structure
-// ZGT_Key_sem  -- you need to set it to make it unique for each team
-// ZGT_Nsema -- total number of semaphores 
 
 #include<stddef.h>
 #define READWRITE 0
 
-int ZGT_Nsema;
 int errno;
-key_t  ZGT_Key_sem;
-int  ZGT_Semid;
 
 zgt_ht * ZGT_Ht;
 zgt_tm * ZGT_Sh;
 zgt_tx * ZGT_Tx;
 int  ZGT_Initp;
+
+// object pools for the hot allocation paths (zgt_slab.h)
+zgt_slab ZGT_Hlink_pool(sizeof(zgt_hlink));
+zgt_slab ZGT_Op_pool(sizeof(zgt_op));
+zgt_slab ZGT_Txq_pool(sizeof(zgt_txq));
+zgt_slab ZGT_Tx_pool(sizeof(zgt_tx));
+zgt_slab ZGT_Node_pool(sizeof(node));
+zgt_slab ZGT_Edge_pool(sizeof(edge));
+zgt_slab ZGT_Undo_pool(sizeof(zgt_undo));
+zgt_slab ZGT_Version_pool(sizeof(zgt_version));
+zgt_slab ZGT_Seg_pool(sizeof(zgt_txseg));
 int Zgt_errno=0;
@@ -0,0 +1,50 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013.
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_HIST_H
+#define ZGT_HIST_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define ZGT_HIST_SUB      5     //2^SUB buckets per power of two: within ~3%
+#define ZGT_HIST_BUCKETS  ((65 - ZGT_HIST_SUB) << ZGT_HIST_SUB)
+
+// Latency histogram: counts of values (ns) in log-linear buckets, values
+// below 2^SUB exact. One thread records into a histogram (each has its
+// own, see zgt_tstats), so add() needs no read-modify-write; other
+// threads may merge it meanwhile and see counts that are not one
+// consistent snapshot, which is fine for reporting.
+
+class zgt_hist
+{
+ public:
+  zgt_hist() {reset();}
+  void reset();
+  void add(uint64_t v);
+  void merge(const zgt_hist *h);      //adds h's counts to ours
+  uint64_t count() const {return n;}
+  uint64_t max() const {return hi;}
+  double mean() const {return n ? (double)sum / n : 0.0;}
+  uint64_t percentile(double p) const;  //p in [0, 100]; upper end of its bucket
+  void json(FILE *f) const;           //{"count":..,"mean":..,"p50":.. }
+
+ private:
+  uint64_t counts[ZGT_HIST_BUCKETS];
+  uint64_t n, sum, hi;
+
+  static int index(uint64_t v);
+  static uint64_t upper(int i);       //largest value of bucket i
+};
+
+extern uint64_t zgt_now_ns();         //CLOCK_MONOTONIC, for latencies
+
+#endif
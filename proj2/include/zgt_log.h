@@ -0,0 +1,123 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013.
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_LOG_H
+#define ZGT_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#define ZGT_LOG_PERIOD  10     //ms between writer passes when nobody waits
+#define ZGT_LOG_KICK    1024   //records buffered by a thread before it wakes the writer
+#define ZGT_LOG_MAGIC   "ZGTLOG2"
+
+// record types
+#define ZGT_LOG_BEGIN        1   //mode: Txtype
+#define ZGT_LOG_READ         2   //obno, before, value, optime; mode: tx status
+#define ZGT_LOG_WRITE        3   //obno, before, value, optime; mode: tx status
+#define ZGT_LOG_COMMIT       4   //followed by RELEASEs and an EOL
+#define ZGT_LOG_ABORT        5   //same; why: ZGT_WHY_* if the lock manager did it
+#define ZGT_LOG_RELEASE      6   //obno, value of one lock freed at commit/abort
+#define ZGT_LOG_EOL          7
+#define ZGT_LOG_IGNORED      8   //op refused; mode: 'B','R','W','C','A'; obno
+                                 //('w': a write by a read-only tx)
+#define ZGT_LOG_NOTX         9   //remove of a tx that is not registered
+#define ZGT_LOG_CYCLE        10  //deadlock cycle found; tid starts it
+#define ZGT_LOG_CYCLE_NEXT   11  //next tid on the cycle
+#define ZGT_LOG_CYCLE_END    12  //tid closes it; obno is the victim
+#define ZGT_LOG_CLR          13  //undo of the tx's latest READ/WRITE not yet undone:
+                                 //obno, before, value
+#define ZGT_LOG_CKPT         14  //checkpoint taken; obno: its redo LSN, value: active txs
+#define ZGT_LOG_SNAPREAD     15  //read-only tx read obno from its snapshot: value, optime
+
+// One log record; fixed width, so the binary log is an array of these
+// after the file header. The text log is the same records run through
+// zgt_log_format(). LSNs start at 1 and have no gaps, so record lsn sits
+// at offset ZGT_LOG_HDR + (lsn-1) * sizeof(zgt_logrec) of a binary log.
+struct zgt_logrec
+{
+  int64_t lsn;
+  int64_t tid;
+  int64_t obno;
+  int32_t value;        //object value after the change
+  int32_t optime;
+  char type;
+  char mode;
+  char why;
+  char pad;
+  int32_t before;       //object value before the change (READ, WRITE, CLR)
+};
+
+#define ZGT_LOG_HDR 16      //bytes ahead of the first binary record
+
+extern const char *zgt_why_names[];
+extern void zgt_logrec_init(zgt_logrec *r, char type, long tid);
+extern int zgt_log_format(const zgt_logrec *r, char *buf, int len);
+extern int zgt_log_header(char *buf, int len);
+
+// a thread's append buffer; recs is filled by the thread, spare is the
+// array the writer took last time and hands back on the next swap
+struct zgt_logbuf
+{
+  pthread_mutex_t latch;
+  zgt_logrec *recs, *spare;
+  int n, cap, sparecap;
+  zgt_logbuf *next;
+};
+
+// Log writer. Threads append records to their own buffer; LSNs are taken
+// under that buffer's latch, so once the writer holds every latch all
+// LSNs handed out so far are in some buffer. The writer swaps the buffers
+// out, places each record by LSN, and issues one write and one fsync for
+// the lot: a commit that waits in wait_durable() while a write is under way
+// goes out with everything else in the next one (group commit). A write
+// or fsync that fails ends the log: nothing after it is reported durable.
+
+class zgt_log
+{
+ public:
+  zgt_log(const char *name, int binary, long lastlsn = 0,  //> 0: append after lastlsn
+          int period = ZGT_LOG_PERIOD);
+  ~zgt_log();                           //writes out everything, then closes
+  int ok() {return fd >= 0 && !__atomic_load_n(&failed, __ATOMIC_RELAXED);}
+  long append(zgt_logrec *r, int n);    //n records with consecutive LSNs; returns the last
+  int wait_durable(long lsn);           //0 once lsn is on disk, -1 if it cannot get there
+  long last() {return __atomic_load_n(&nextlsn, __ATOMIC_RELAXED);}
+
+ private:
+  int fd;
+  int binary;
+  int period;
+  long nextlsn;                         //last LSN handed out
+  long durable;                         //everything up to here is on disk
+  long want;                            //highest LSN a committer waits for
+  int stop;
+  int failed;                           //a write or fsync failed; see fail()
+  long gen;                             //tells this log's thread buffers from older ones
+  zgt_logbuf *bufs;                     //every thread's buffer
+  pthread_mutex_t bufslock;             //guards bufs; taken before any latch
+  pthread_mutex_t lock;                 //durable, want, stop
+  pthread_cond_t kick;                  //wakes the writer
+  pthread_cond_t done;                  //durable moved
+  pthread_t writer;
+  zgt_logrec *batch;                    //records of one pass, in LSN order
+  long batchcap;
+  char *text;
+  long textcap;
+
+  zgt_logbuf *my_buf();
+  int flush();
+  void fail(const char *what);
+  static void *writer_main(void *);
+};
+
+#endif
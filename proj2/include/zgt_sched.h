@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013.
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_SCHED_H
+#define ZGT_SCHED_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ZGT_SCH_MAGIC "ZGTSCH1"
+
+// schedule operations
+#define ZGT_SCH_LOG      1   //text: the log file name
+#define ZGT_SCH_BEGIN    2   //tid, txtype
+#define ZGT_SCH_READ     3   //tid, obno
+#define ZGT_SCH_WRITE    4   //tid, obno
+#define ZGT_SCH_ABORT    5   //tid
+#define ZGT_SCH_COMMIT   6   //tid
+#define ZGT_SCH_DETECT   7
+#define ZGT_SCH_CHOOSE   8
+#define ZGT_SCH_END      9
+#define ZGT_SCH_COMMENT  10  //text schedules only
+#define ZGT_SCH_ERROR    11  //a line that is none of the above; ends the schedule
+
+// one operation as next() hands it out. text and line point into the
+// mapped schedule and are not terminated: text is the log name of a LOG
+// or the line of an ERROR, line the whole line an op came from (NULL in
+// a compiled schedule).
+struct zgt_schedop
+{
+  char op;
+  char txtype;
+  long tid;
+  long obno;
+  const char *text;
+  int len;
+  const char *line;
+  int linelen;
+};
+
+// Compiled schedule: the magic, padded to a record, then one of these per
+// operation. A LOG or ERROR record is followed by its text, len bytes
+// padded to a whole number of records.
+struct zgt_schedrec
+{
+  int64_t tid;
+  int64_t obno;
+  char op;
+  char txtype;
+  char pad[2];
+  int32_t len;
+};
+
+// Reads a schedule, text or compiled, straight out of a read-only mapping
+// of the file: text lines are tokenized in place, nothing is copied.
+
+class zgt_sched
+{
+ public:
+  zgt_sched(const char *name);
+  ~zgt_sched();
+  int ok() {return fd >= 0;}
+  int compiled() {return bin;}
+  int next(zgt_schedop *op);            //1, or 0 at the end of the schedule
+  static int format(const zgt_schedop *op, char *buf, int len);  //as a text line
+
+ private:
+  int fd;
+  int bin;
+  char *map;
+  size_t size;
+  size_t pos;
+
+  int next_text(zgt_schedop *op);
+  int next_bin(zgt_schedop *op);
+};
+
+extern long zgt_sched_compile(zgt_sched *in, const char *out);  //ops written; -1 on error
+
+#endif
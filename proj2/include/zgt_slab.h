@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject 
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013. 
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_SLAB_H
+#define ZGT_SLAB_H
+
+#include <stddef.h>
+#include <pthread.h>
+
+#define ZGT_SLAB_CHUNK     256   //objects carved per chunk
+#define ZGT_SLAB_BATCH     32    //objects moved between a thread and the pool
+#define ZGT_SLAB_MAX_POOLS 16
+
+// Fixed-size object pool for the hot allocation paths (lock entries, op
+// queue nodes, registry entries, transactions, wait-for graph nodes and
+// edges). Each thread keeps a small cache of free objects per pool and
+// only takes the pool latch to move ZGT_SLAB_BATCH objects at a time in or
+// out, so alloc and free normally touch no shared state. Chunks are
+// returned to the system only when the pool is destroyed; memory use
+// follows the peak number of live objects, not the length of the run.
+
+class zgt_slab
+{
+ public:
+  zgt_slab(size_t objsize);
+  ~zgt_slab();
+  void *get();             //NULL if memory is not there
+  void put(void *);
+
+ private:
+  size_t size;             //object size, at least one pointer
+  int id;                  //index of this pool in each thread's cache
+  void *freelist;          //objects spilled by threads
+  void *chunks;            //every chunk carved so far
+  pthread_mutex_t latch;
+
+  int refill();
+  void spill();
+};
+
+extern zgt_slab ZGT_Hlink_pool;   //zgt_hlink: lock table entries
+extern zgt_slab ZGT_Op_pool;      //zgt_op: queued operations
+extern zgt_slab ZGT_Txq_pool;     //zgt_txq: registry entries
+extern zgt_slab ZGT_Tx_pool;      //zgt_tx
+extern zgt_slab ZGT_Node_pool;    //wait-for graph nodes
+extern zgt_slab ZGT_Edge_pool;    //wait-for graph edges
+extern zgt_slab ZGT_Undo_pool;    //zgt_undo: per-tx change chain
+extern zgt_slab ZGT_Version_pool; //zgt_version: committed object values
+extern zgt_slab ZGT_Seg_pool;     //zgt_txseg: segments a tx holds locks in
+
+#endif
@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013.
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_STATS_H
+#define ZGT_STATS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "zgt_hist.h"
+
+#define ZGT_STATS_MODES  ZGT_NMODES   //lock modes counted: IS, IX, S, SIX, X
+#define ZGT_STATS_HOT    256    //contention slots per thread
+#define ZGT_STATS_TOPK   10     //hottest objects in a snapshot
+#define ZGT_STATS_CHAIN  32     //chain lengths counted one by one; longer ones share the last
+#define ZGT_STATS_PERIOD 1000   //default dump period in ms
+
+// Always-on engine statistics. Every thread counts into a block of its
+// own, allocated on its first event and never freed, so the hot paths
+// write only their own cache lines and take no latch. A snapshot adds the
+// blocks up while the engine runs; counts that change meanwhile may be
+// seen in one total and not yet in another.
+
+// one object's conflicts in a thread's slot; a slot keeps the obno that
+// conflicts most often among those hashed to it (Misra-Gries, one counter)
+struct zgt_hotslot
+{
+  long obno;
+  uint64_t n;
+};
+
+struct zgt_tstats
+{
+  uint64_t req[ZGT_STATS_MODES];      //set_lock calls
+  uint64_t granted[ZGT_STATS_MODES];  //granted right away
+  uint64_t waited[ZGT_STATS_MODES];   //queued behind a conflict
+  uint64_t denied[ZGT_STATS_MODES];   //refused by the conflict policy
+  uint64_t commits;
+  uint64_t aborts[ZGT_WHY_COUNT];     //by ZGT_WHY_*
+  uint64_t deadlocks;                 //cycles broken by the detector
+  uint64_t chain[ZGT_STATS_CHAIN];    //lock table bucket length at each request
+  zgt_hist wait;                      //ns spent in TR_WAIT, granted or not
+  zgt_hist lock;                      //ns from set_lock to the lock held; granted ones only
+  zgt_hist commit;                    //ns from the commit record to the locks released
+  zgt_hotslot hot[ZGT_STATS_HOT];
+  zgt_tstats *next;
+} __attribute__((aligned(ZGT_CACHE_LINE)));
+
+// totals over every thread
+struct zgt_stats_snap
+{
+  uint64_t req[ZGT_STATS_MODES];
+  uint64_t granted[ZGT_STATS_MODES];
+  uint64_t waited[ZGT_STATS_MODES];
+  uint64_t denied[ZGT_STATS_MODES];
+  uint64_t commits;
+  uint64_t aborts[ZGT_WHY_COUNT];
+  uint64_t deadlocks;
+  uint64_t chain[ZGT_STATS_CHAIN];
+  zgt_hist wait;
+  zgt_hist lock;
+  zgt_hist commit;
+  int nhot;
+  zgt_hotslot hot[ZGT_STATS_TOPK];    //most conflicts first
+  int threads;
+};
+
+extern __thread zgt_tstats *zgt_tl_stats;
+extern zgt_tstats *zgt_stats_new();
+
+inline zgt_tstats *zgt_stats_mine()
+{
+  return (zgt_tl_stats != NULL) ? zgt_tl_stats : zgt_stats_new();
+}
+
+// index of a lock mode in the per-mode counters
+inline int zgt_stats_mode(char mode)
+{
+  return (zgt_lock_index(mode));
+}
+
+// only the owning thread writes a block; a plain add, but one the
+// snapshot may read concurrently
+#define ZGT_STAT_ADD(field, v) \
+  __atomic_store_n(&(field), __atomic_load_n(&(field), __ATOMIC_RELAXED) + (v), __ATOMIC_RELAXED)
+
+extern void zgt_stats_conflict(long obno);      //obno was requested and held
+extern void zgt_stats_snapshot(zgt_stats_snap *s);
+extern void zgt_stats_json(FILE *f, const zgt_stats_snap *s);
+
+#endif
@@ -0,0 +1,114 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013.
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_STORE_H
+#define ZGT_STORE_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "zgt_def.h"
+
+#define ZGT_STORE_OBJS   (1L << 20)   //default objects in the store
+#define ZGT_STORE_SHIFT  12           //a shard is 2^SHIFT objects
+#define ZGT_STORE_HDR    4096         //bytes ahead of the objects in a store file
+#define ZGT_STORE_MAGIC  "ZGTOBJ1"
+
+// a committed value of an object, as of commit timestamp cts
+struct zgt_version
+{
+  long cts;
+  int value;
+  zgt_version *next;      //older
+};
+
+// One object. Each has a cache line to itself, so threads working on
+// neighbouring objects do not take each other's lines away.
+class item {
+  public:
+	int value;              //latest value, uncommitted changes included
+	int cvalue;             //committed value older than every version
+	long lsn;               //last log record that changed value
+	zgt_version *versions;  //committed values, newest first (zgt_mvcc.C)
+	pthread_mutex_t latch;  //value and lsn change together, in LSN order;
+	                        //also guards cvalue and versions
+} __attribute__((aligned(ZGT_CACHE_LINE)));
+
+// 2^ZGT_STORE_SHIFT consecutive objects (fewer in the last shard). The
+// objects of a shard are set up (latches, no versions) on its first use.
+// dirty tells the checkpoint which shards it has to copy again.
+struct zgt_shard
+{
+  item *obj;
+  long n;
+  int ready;
+  int dirty;              //changed since the last checkpoint copied it
+  pthread_mutex_t latch;  //taken by whoever sets the shard up
+} __attribute__((aligned(ZGT_CACHE_LINE)));
+
+// store file: this header, padded to ZGT_STORE_HDR, then nobj items
+struct zgt_storehdr
+{
+  char magic[8];
+  int64_t nobj;
+  int32_t objsize;        //sizeof(item) of the program that made it
+  int32_t pad;
+};
+
+// Object store: objects 0..size()-1 in one contiguous mapping, sized at
+// startup. The mapping is anonymous, so pages nobody touches cost
+// nothing, or a file, so a dataset left by an earlier run is there at
+// once. Shards are set up as they are first used, so neither way is the
+// store initialized object by object at startup.
+
+class zgt_store
+{
+ public:
+  zgt_store(long nobj, const char *file = NULL);  //file: an existing one sets the size
+  ~zgt_store();
+  int ok() {return base != NULL;}
+  long size() {return nobj;}
+  item *at(long obno)     //NULL if obno is not in the store
+    {
+      zgt_shard *s;
+
+      if ((unsigned long)obno >= (unsigned long)nobj) return (NULL);
+      s = &shards[obno >> ZGT_STORE_SHIFT];
+      if (!__atomic_load_n(&s->ready, __ATOMIC_ACQUIRE)) prepare(s);
+      return (&s->obj[obno & ((1L << ZGT_STORE_SHIFT) - 1)]);
+    }
+  int nshards() {return nshard;}
+  item *shard(int i, long *n);  //objects of shard i; NULL if all still 0
+  void touch(long obno)         //obno changed; call it under the object latch
+    {
+      zgt_shard *s = &shards[obno >> ZGT_STORE_SHIFT];
+
+      if (!__atomic_load_n(&s->dirty, __ATOMIC_RELAXED))
+        __atomic_store_n(&s->dirty, 1, __ATOMIC_RELAXED);
+    }
+  int clean(int i)              //was shard i dirty? It is not any more
+    {return (__atomic_exchange_n(&shards[i].dirty, 0, __ATOMIC_ACQ_REL));}
+  void clear();                 //every object 0, no versions
+  void reset_lsn();             //every object's lsn 0; values stay
+  void sync();                  //a store file is written out
+
+ private:
+  item *base;
+  long nobj;
+  int nshard;
+  zgt_shard *shards;
+  char *map;              //the mapping: the store file, or just the objects
+  size_t maplen;
+  int fd;                 //store file; -1 if anonymous
+
+  void prepare(zgt_shard *s);
+};
+
+#endif
@@ -0,0 +1,216 @@
+/*------------------------------------------------------------------------------
+//                         RESTRICTED RIGHTS LEGEND
+//
+// Use,  duplication, or  disclosure  by  the  Government is subject 
+// to restrictions as set forth in subdivision (c)(1)(ii) of the Rights
+// in Technical Data and Computer Software clause at 52.227-7013. 
+//
+// Copyright 1989, 1990, 1991 Texas Instruments Incorporated.  All rights reserved.
+//------------------------------------------------------------------------------
+*/
+
+#ifndef ZGT_STRIPE_H
+#define ZGT_STRIPE_H
+
+#include <stdlib.h>
+#include <pthread.h>
+
+// One bucket of a striped table: a chain of E linked through E::next under
+// its own latch, on its own cache line so that threads hashing to
+// different buckets never touch the same line.
+template <class E> struct zgt_stripe
+{
+  pthread_mutex_t latch;
+  E *head;
+  int count;              //entries chained in this bucket
+} __attribute__((aligned(ZGT_CACHE_LINE)));
+
+// A bucket array. The table swaps in a new one when it grows; old arrays
+// are kept (marked moved) until the table is destroyed so that a thread
+// still spinning on an old latch never touches freed memory.
+template <class E> struct zgt_stripearr
+{
+  int size;               //a power of 2
+  int mask;
+  int moved;              //set once the entries were rehashed elsewhere
+  zgt_stripe<E> *bucket;
+  zgt_stripearr *retired; //older arrays, freed with the table
+};
+
+// Latch-striped hash table of E, shared by the lock table and the
+// transaction registry. It owns the buckets, not the entries: callers
+// latch a bucket with lock(), walk and relink its chain themselves and
+// keep count up to date; resize() rehashes with the key function given
+// to init().
+template <class E> class zgt_stripes
+{
+ public:
+  zgt_stripes() {arr = NULL;}
+  ~zgt_stripes();
+  int init(int size, unsigned long (*key)(const E *));   //-1 if memory is not there
+  zgt_stripe<E> *lock(unsigned long h);  //latches the bucket h hashes to
+  void unlock(zgt_stripe<E> *b) {pthread_mutex_unlock(&b->latch);}
+  int resize(int new_size);              //rehash into a larger bucket array
+  void scan(void (*fn)(zgt_stripe<E> *, int, void *), void *arg);
+  int size() {return (__atomic_load_n(&arr, __ATOMIC_ACQUIRE)->size);}
+  long total();                          //entries, summed without latches
+
+ private:
+  zgt_stripearr<E> *arr;          //current bucket array
+  pthread_mutex_t resize_latch;   //serializes resize() and scan()
+  unsigned long (*key)(const E *);
+
+  static zgt_stripearr<E> *alloc(int size);
+};
+
+// allocates a cache-line aligned bucket array of size buckets (a power of 2)
+
+template <class E> zgt_stripearr<E> *zgt_stripes<E>::alloc(int size)
+{
+  zgt_stripearr<E> *t;
+  void *mem;
+  int i;
+
+  t = (zgt_stripearr<E> *)malloc(sizeof(zgt_stripearr<E>));
+  if (t == NULL) return (NULL);
+  if (posix_memalign(&mem, ZGT_CACHE_LINE, size * sizeof(zgt_stripe<E>)) != 0){
+    free(t);
+    return (NULL);
+  }
+  t->bucket = (zgt_stripe<E> *)mem;
+  for (i=0;i<size;i++){
+    pthread_mutex_init(&t->bucket[i].latch, NULL);
+    t->bucket[i].head = NULL;
+    t->bucket[i].count = 0;
+  }
+  t->size = size;
+  t->mask = size - 1;
+  t->moved = 0;
+  t->retired = NULL;
+  return (t);
+}
+
+// size is rounded up to a power of 2
+
+template <class E> int zgt_stripes<E>::init(int size, unsigned long (*keyfn)(const E *))
+{
+  int n;
+
+  for (n = 1; n < size; n <<= 1);
+  if ((arr = alloc(n)) == NULL) return (-1);
+  pthread_mutex_init(&resize_latch, NULL);
+  key = keyfn;
+  return (0);
+}
+
+// latches and returns the bucket h hashes to. If a resize swapped the
+// bucket array while we were waiting on the latch, retry on the new one.
+
+template <class E> zgt_stripe<E> *zgt_stripes<E>::lock(unsigned long h)
+{
+  zgt_stripearr<E> *t;
+  zgt_stripe<E> *b;
+
+  for (;;){
+    t = __atomic_load_n(&arr, __ATOMIC_ACQUIRE);
+    b = &t->bucket[h & t->mask];
+    pthread_mutex_lock(&b->latch);
+    if (!t->moved) return (b);
+    pthread_mutex_unlock(&b->latch);
+  }
+}
+
+// rehashes every entry into a bucket array of new_size (rounded up to a
+// power of 2). Holds every old latch while moving entries, so concurrent
+// callers simply wait and then retry on the new array. Returns -1 if the
+// table is already that large or memory is not there.
+
+template <class E> int zgt_stripes<E>::resize(int new_size)
+{
+  zgt_stripearr<E> *t, *nt;
+  zgt_stripe<E> *nb;
+  E *e, *next, **tail;
+  int size, i;
+
+  for (size = 1; size < new_size; size <<= 1);
+
+  pthread_mutex_lock(&resize_latch);
+  t = arr;
+  if (size <= t->size || (nt = alloc(size)) == NULL){
+    pthread_mutex_unlock(&resize_latch);
+    return (-1);
+  }
+  for (i=0;i<t->size;i++)
+    pthread_mutex_lock(&t->bucket[i].latch);
+
+  // walk the old chains front to back and append, so entries with the
+  // same key keep their relative order in the new chain
+  for (i=0;i<t->size;i++){
+    for (e = t->bucket[i].head; e != NULL; e = next){
+      next = e->next;
+      nb = &nt->bucket[key(e) & nt->mask];
+      for (tail = &nb->head; *tail != NULL; tail = &(*tail)->next);
+      e->next = NULL;
+      *tail = e;
+      nb->count++;
+    }
+    t->bucket[i].head = NULL;
+    t->bucket[i].count = 0;
+  }
+  nt->retired = t;
+  t->moved = 1;
+  __atomic_store_n(&arr, nt, __ATOMIC_RELEASE);
+
+  for (i=0;i<t->size;i++)
+    pthread_mutex_unlock(&t->bucket[i].latch);
+  pthread_mutex_unlock(&resize_latch);
+  return (0);
+}
+
+// calls fn on every bucket of the current array with its index, one
+// bucket latched at a time; no resize runs meanwhile
+
+template <class E> void zgt_stripes<E>::scan(void (*fn)(zgt_stripe<E> *, int, void *), void *arg)
+{
+  zgt_stripearr<E> *t;
+  int i;
+
+  pthread_mutex_lock(&resize_latch);
+  t = arr;
+  for (i=0;i<t->size;i++){
+    pthread_mutex_lock(&t->bucket[i].latch);
+    fn(&t->bucket[i], i, arg);
+    pthread_mutex_unlock(&t->bucket[i].latch);
+  }
+  pthread_mutex_unlock(&resize_latch);
+}
+
+template <class E> long zgt_stripes<E>::total()
+{
+  zgt_stripearr<E> *t;
+  long n;
+  int i;
+
+  t = __atomic_load_n(&arr, __ATOMIC_ACQUIRE);
+  for (n=0, i=0; i<t->size; i++)
+    n += __atomic_load_n(&t->bucket[i].count, __ATOMIC_RELAXED);
+  return (n);
+}
+
+template <class E> zgt_stripes<E>::~zgt_stripes()
+{
+  zgt_stripearr<E> *t, *old;
+  int i;
+
+  if (arr == NULL) return;
+  for (t = arr; t != NULL; t = old){
+    old = t->retired;
+    for (i=0;i<t->size;i++)
+      pthread_mutex_destroy(&t->bucket[i].latch);
+    free(t->bucket);
+    free(t);
+  }
+  pthread_mutex_destroy(&resize_latch);
+}
+
+#endif
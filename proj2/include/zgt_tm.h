@@ -2,30 +2,106 @@
 #include <string>
 #include <stdlib.h>
 #include "zgt_tx.h"
+#include "zgt_slab.h"
 #include <iostream>
+#include <set>
+#include <vector>
 #include "zgt_def.h"
 #include "zgt_ddlock.h"
-#define MAX_ITEMS 15
-#define MAX_TRANSACTIONS 10
+#include "zgt_log.h"
+#include "zgt_hist.h"
+#include "zgt_stats.h"
+#include "zgt_store.h"
 #define MAX_FILENAME  50
-#define NTHREADS        100
+#define ZGT_MAX_WORKERS 1024   //upper bound on the worker pool
+#define ZGT_POOL_GROW   4      //the pool grows to this many times its size at most
+#define ZGT_TXTAB_SIZE  64     //initial registry buckets
+#define ZGT_TXTAB_LOAD  2      //entries per bucket before it doubles
+#define ZGT_CKPT_PERIOD 1000   //default checkpoint period in ms (binary log only)
 
 using namespace std;
 
 
-class item {
-  public:
-	int value;
+struct param
+{
+  long tid, obno, count;
+  char Txtype;
+};
+
+// one queued operation of a transaction: the routine that runs it
+// (begintx, readtx, ...) and its argument
+// returned by an op that left its tx parked on a lock wait; the worker
+// puts the op back and runs it again once the wait is over
+#define ZGT_PARKED ((void *)1)
+
+struct zgt_op
+{
+  void *(*fn)(void *);
+  struct param arg;
+  zgt_op *next;
+};
+
+// Registry entry of one transaction id: the tx object (NULL before its
+// BeginTx has run and again once it committed or aborted) and its pending
+// operations, run strictly in FIFO order. An entry is on the run queue (or
+// being executed) only while queued is set, so at most one worker ever runs
+// a given transaction's operations; that worker is also the only thread
+// that sets or clears tx, under the bucket latch (attach/detach) so scan()
+// callbacks may look at it. Entries are created by submit() and dropped by
+// the worker once the tx has ended and no operation is left.
+struct zgt_txq
+{
+  long tid;
+  zgt_tx *tx;
+  zgt_op *first, *last;
+  long seq;             //sequence number of the next operation submitted
+  int queued;
+  int ended;            //its commit or abort has been submitted
+  zgt_txq *nextrun;
+  zgt_txq *next;        //links entries hashed to the same bucket
+};
+
+typedef zgt_stripe<zgt_txq> zgt_txbucket;
 
-	item(int k){
-	  value=k;
-	};
+// Transaction registry keyed by tid: latch-striped buckets, doubled when
+// the number of entries passes ZGT_TXTAB_LOAD per bucket, so lookups stay
+// O(1) however many transactions are live.
+class zgt_txtab
+{
+ public:
+  zgt_txtab(int size);
+  ~zgt_txtab();
+  zgt_txq *find(long tid);        //NULL if tid has no entry
+  zgt_txq *add(long tid);         //find, or create an empty entry
+  void remove(zgt_txq *q);
+  void attach(zgt_txq *q, zgt_tx *tx);        //q->tx = tx under the latch
+  int detach(zgt_txq *q, zgt_tx *tx);         //q->tx = NULL if it is tx; -1 if not
+  void scan(void (*fn)(zgt_txq *, void *), void *arg);
 
-	~item();
- };
+ private:
+  zgt_stripes<zgt_txq> table;
+  long count;                     //entries in the table
+  zgt_txbucket *lock_bucket(long tid)
+    {return (table.lock(hashing(tid)));}
+  static unsigned long hashing(long tid)
+    {
+      unsigned long k = (unsigned long)tid;
+      k ^= k >> 33;
+      k *= 0xFF51AFD7ED558CCDUL;
+      k ^= k >> 33;
+      return (k);
+    }
+  static unsigned long entry_key(const zgt_txq *q)
+    {return (hashing(q->tid));}
+};
 
 //class wait_for;
 
+extern const char *policy_names[];    //indexed by ZGT_DETECT..
+extern int policy_byname(const char *name);
+
+struct zgt_ckobj;
+
 class zgt_tm{
 	
 	public:
@@ -35,38 +111,135 @@ class zgt_tm{
 	friend class wait_for;
 
 	long lastid;
-	zgt_tx *lastr;
-	zgt_hlink *head[ZGT_DEFAULT_HASH_TABLE_SIZE];
-	pthread_mutex_t mutexpool[MAX_TRANSACTIONS+1];
-	pthread_cond_t condpool[MAX_TRANSACTIONS+1];
-	int condset[MAX_TRANSACTIONS+1];
-	item *objarray[MAX_ITEMS];
-	int  optime[MAX_TRANSACTIONS+1];
-  	int sem;
-	char *logfilename; // logfile -> logfilename
-    FILE *logfile;  //added by sharma on 10/20/2020 to avoid confusion
+	zgt_txtab *txtab;           //live transactions and their op queues
+	zgt_store *store;           //the objects (zgt_store.h)
+	char logfilename[MAX_FILENAME]; // logfile -> logfilename
+    zgt_log *log;   //NULL until the schedule's Log line
+    int binlog;     //write the log as binary zgt_logrec's (zgt_logdump reads it)
 
 	//Fall 2014[jay]. Pointer for wait_for => wait for graph
 	wait_for *waitgraph;
+	//background deadlock detector; runs a pass every ddperiod ms. Under
+	//ZGT_TIMEOUT it times out lock waits instead, every locktimeout /
+	//ZGT_TIMEOUT_TICKS ms
+	pthread_t ddthread;
+	pthread_mutex_t ddlock;
+	pthread_cond_t ddcv;        //wakes the detector early (ddkick(), shutdown)
+	int ddperiod;
+	int ddstop;
+	int ddkicked;               //a wait may have closed a cycle: run a pass now
+	int policy;                 //ZGT_DETECT, ZGT_WAIT_DIE, ... (zgt_def.h)
+	int locktimeout;            //ms a lock wait may take under ZGT_TIMEOUT
+	int segsize;                //objects per segment; 0: no segment locks
+	int escalate;               //object locks per segment before escalation; 0: never
+	static void *ddlockdet(void *);
+	//checkpoint thread (zgt_recov.C); runs while a binary log is open
+	pthread_t ckthread;
+	pthread_mutex_t cklock;
+	pthread_cond_t ckcv;
+	int ckperiod;
+	int ckstop;
+	int ckrunning;
+	vector<zgt_ckobj> *ckcopy;  //per store shard: what the last checkpoint took
+	static void *ckptd(void *);
+	void startCkpt();
+	void stopCkpt();
+	int recover(const char *name);   //replay an existing binary log
+
+	//MVCC (zgt_mvcc.C): read-only txs read the versions committed up to
+	//their snapshot and take no locks. vlock orders commits while a
+	//snapshot is active and guards snaps; a commit's versions are all in
+	//place before clock moves past it, so a snapshot sees all of a commit
+	//or none of it. With no snapshot active, commits go straight into
+	//cvalue without vlock; snapBegin waits for those in progress.
+	long clock;                 //commit timestamp of the last commit published
+	multiset<long> snaps;       //snapshots of the active read-only txs
+	long nsnaps;                //snaps.size(), read without vlock
+	pthread_mutex_t vlock;
+	void resetVersions();       //one version per object: its current value
+
+	//for zgt_bench; the latencies and commit/abort counts it reports are
+	//kept per thread in zgt_tstats
+	int optimefix;              //optime of every tx if >= 0; see optime_for()
+
+	//stats thread (zgt_stats.C): appends a snapshot of the per-thread
+	//counters to statsfile every statsperiod ms
+	pthread_t stthread;
+	pthread_mutex_t stlock;
+	pthread_cond_t stcv;
+	FILE *statsfile;
+	int statsperiod;
+	int ststop;
+	int strunning;
+	static void *statsd(void *);
+
+    //worker pool. Every operation is queued on its transaction's txq;
+    //transactions with pending operations wait on the run queue
+    //(runfirst..runlast) for a worker. A transaction whose lock request
+    //has to wait is parked: off the run queue, its worker free, until
+    //wake() puts it back. poollock guards all of it, and is held
+    //whenever an entry is added to or dropped from txtab.
+    zgt_txq *runfirst, *runlast;
+    pthread_mutex_t poollock;
+    pthread_cond_t poolwork;    //idle workers wait here for a runnable tx
+    pthread_cond_t pooldone;    //waitIdle() waits here for npending == 0
+    pthread_cond_t poolquiet;   //waitQuiet() waits here for every worker idle
+    pthread_t workers[ZGT_MAX_WORKERS];
+    int nworkers;               //threads started
+    int maxworkers;             //ZGT_POOL_GROW times the pool asked for
+    int nidle;                  //workers waiting on poolwork
+    int nblocked;               //workers asleep on the log
+    long npending;              //operations submitted but not finished
+    int shutdown;
 
-    //used to generate seq num for operations of EACH Tx.  
-    //Every statement within a transaction is given a different number using SEQNUM[tid]
-    // and every statement waits on that value of count to match condset. condset is initialized to 0 and 
-    //decremented everytime an operation of a Tx finishes.
-    int SEQNUM[MAX_TRANSACTIONS+1];
-    pthread_t   threadid[NTHREADS];
+    static void *worker(void *);
+    int submit(long tid, void *(*fn)(void *), long obno, char Txtype);
+    int spawn_worker();
+    void runq_add(zgt_txq *q);
 
 	public:
 	
-		zgt_tm();
+		zgt_tm(int policy = ZGT_DETECT,  //lock conflict policy
+		       int poolsize = 0,   //0: one worker per online cpu
+		       int ddperiod = ZGT_DDLOCK_PERIOD,  //detector period in ms; 0: off
+		       int locktimeout = ZGT_LOCK_TIMEOUT,  //ms, for ZGT_TIMEOUT
+		       int binlog = 0,     //binary log records instead of text
+		       int ckperiod = ZGT_CKPT_PERIOD,  //checkpoint period in ms; 0: off
+		       int segsize = ZGT_SEG_SIZE,     //objects per lock segment; 0: none
+		       int escalate = ZGT_ESCALATE,    //escalation threshold; 0: never
+		       long nobj = ZGT_STORE_OBJS,     //objects in the store
+		       const char *storefile = NULL);  //map the store from this file
         void openlog(string lfile);
         //Fall 2014[jay]. BeginTx modified for TxType; R= Read Only, W=Read/Write
-		int BeginTx(long tid, int thrNum,char Txtype);
-		int CommitTx(long tid, int thrNum);
-		int AbortTx(long tid, int thrNum);
-		int TxRead(long tid,long obno, int thrNum);
-		int TxWrite(long tid,long obno, int thrNum);
-        int endTm(int thrNum);
+		int BeginTx(long tid, char Txtype);
+		int CommitTx(long tid);
+		int AbortTx(long tid);
+		int TxRead(long tid,long obno);
+		int TxWrite(long tid,long obno);
+        int endTm();
+        long logwrite(zgt_logrec *r, int n);   //append to the log; returns the LSN
+        int logsync(long lsn);      //wait until lsn is durable; -1: it never will be
+        int checkpoint();           //fuzzy checkpoint to <log>.ckpt
+        void dropCkcopy();          //forget what the last checkpoint took
+        void removeCkpt();          //delete <log>.ckpt of an earlier log
+        int startStats(const char *file, int period);   //periodic stats dump
+        void stopStats();
+        long snapBegin();           //snapshot timestamp for a read-only tx
+        void snapEnd(long snap);
+        void publish(zgt_tx *tx);   //tx's changes become a committed version
+        int snapRead(long obno, long snap);   //value of obno as of snap
+        int optime_for(long tid);   //sleep factor of a tx; fixed per tid
+        long sgno_of(long obno)     //segment obno is locked under
+          {return (segsize > 0) ? obno / segsize : 1;}
+        void waitIdle();            //wait until every submitted op finished
+        void waitQuiet();           //wait until no op is running or runnable
+        void crash();               //exit as a crash would, the log on disk
+        void endLeftover();         //abort txs the schedule left open
+        void worker_blocked();      //a worker is about to wait on the log
+        int park(zgt_txq *q);       //leave q's tx waiting off the worker; 0: no need
+        void wake(zgt_tx *tp);      //tp's wait is over; tp->waitlock is held
+        void worker_unblocked();
+        void ddkick();              //detection pass now; see wait_for::end_edges
 		int ddlockDet();
 		int chooseVictim();
 		~zgt_tm();
@@ -15,19 +15,70 @@
 #include <stdlib.h>
 #include <sys/signal.h>
 #include <pthread.h>
+#include <stdint.h>
+#include "zgt_stripe.h"
 
+class zgt_tx;
+struct zgt_txq;
+
+// A lock table entry. Entries for the same object sit in their bucket chain
+// in arrival order; granted ones hold the lock, the others wait their turn
+// (FIFO) and are granted by whoever releases a conflicting lock.
 struct zgt_hlink
 {
   char lockmode;
+  char granted;           //1: holds the lock; 0: waiting for it
+  char upgrade;           //waiting to convert the tx's granted entry
   long sgno;
   long obno;
   long tid;
   pthread_t pid;
+  zgt_tx *tx;             //owner; a waiter is woken through zgt_tm::wake()
 
   zgt_hlink *next;        //links nodes hashed to the same bucket
   zgt_hlink *nextp;       //links nodes of the same transaction
 };
 
+extern int zgt_lock_compat(char held, char req);
+extern char zgt_lock_sup(char held, char req);      //weakest mode covering both
+extern int zgt_lock_covers(char seg, char obj);     //seg lock implies obj lock
+extern const char *zgt_lock_names[ZGT_NMODES];
+
+// row/column of a mode in the compatibility matrix; -1 for none (' ')
+inline int zgt_lock_index(char mode)
+{
+  switch (mode){
+  case ZGT_IS:  return (0);
+  case ZGT_IX:  return (1);
+  case ZGT_S:   return (2);
+  case ZGT_SIX: return (3);
+  case ZGT_X:   return (4);
+  }
+  return (-1);
+}
+
+// a segment a tx has locked: the mode it holds on the segment itself and
+// how many object locks it holds under it (set_lock, escalation)
+struct zgt_txseg
+{
+  long sgno;
+  char mode;              //' ' until a segment lock is granted
+  char hasx;              //one of the object locks is X
+  int nobj;
+  zgt_txseg *next;
+};
+
+// one change a tx made to an object, newest first on zgt_tx::undo; abort
+// takes delta back out (a CLR) instead of restoring the before image,
+// since readers holding S locks change the value too
+struct zgt_undo
+{
+  long lsn;               //the READ/WRITE record
+  long obno;
+  int delta;
+  zgt_undo *next;
+};
+
 // Local declarations
 class zgt_tx {
 
@@ -44,10 +95,23 @@ class zgt_tx {
   char status;
   char lockmode;
   char Txtype; //transaction type R = Read-only or W = Read/Write
-  int semno;    // Txi uses semaphore i; sem 0 for TM
   zgt_hlink *head;           // head of lock table
+  zgt_hlink *wait;           // lock request we are waiting on, if any
+  pthread_mutex_t waitlock;  // protects wait->granted for this tx
+  zgt_txq *parkq;            // its registry entry while parked on wait (zgt_tm::park)
+  uint64_t lockstart;        // set_lock() began; kept across a park
+  uint64_t waitstart;        // the pending wait began
+  uint64_t deadline;         // ZGT_TIMEOUT: the pending wait gives up then (zgt_ht::expire)
+  char victim;               // must abort at its next wait (deadlock victim, wounded)
+  char abortwhy;             // ZGT_WHY_*: logged when the lock manager aborts it
+  int nlocks;                // locks granted so far; victim selection cost
+  long ts;                   // begin order; larger is younger
+  long firstlsn;             // its BeginTx record; checkpoints keep it
+  zgt_undo *undo;            // its changes, newest first
+  zgt_txseg *segs;           // segments it holds locks in
+  long snap;                 // read-only tx: its snapshot timestamp; else -1
+  int optime;                // busy-wait factor while holding a lock
   zgt_hlink *others_lock(zgt_hlink *, long, long); 
-  zgt_tx *nextr;
   
   public :
     
@@ -60,11 +124,23 @@ class zgt_tx {
   long set_tid(long t){tid = t; return tid;}
   char get_status() {return status;}
   int set_lock(long, long, long, int, char);
+  int acquire(long, long, char);     //one lock table request, waits if it must
+  int wait_done(zgt_hlink *);        //the wait on a request is over: keep or withdraw it
+  zgt_txseg *segment(long);          //this tx's entry for a segment
+  int escalate(zgt_txseg *);         //object locks of a segment -> one segment lock
+  void forget_segs();
   int end_tx();
   int cleanup();
   zgt_tx(long,char,char,pthread_t);
+  ~zgt_tx();
+  static void *operator new(size_t);
+  static void operator delete(void *);
   void perform_readWrite(long, long, char);
-  int  setTx_semno(long, int);
+  void update(char, long, int);      //change obno by delta, WAL first
+  void rollback();                   //undo every change, newest first
+  void snapshot_read(long);          //read-only tx: read obno, no lock
+  void forget_undo();
+  long log_end(char, char);          //commit/abort record plus released locks
   void print_tm();
   //  void  wait_for_operation(long );
   //void  finish_operation(long);
@@ -74,6 +150,9 @@ class zgt_tx {
 
 // The Zeitgeist encapsulation object hash table class
 
+// One bucket of the lock table (see zgt_stripes)
+typedef zgt_stripe<zgt_hlink> zgt_hbucket;
+
 class zgt_ht
 {
 
@@ -84,10 +163,12 @@ class zgt_ht
 
   /*  methods  */
   
-  zgt_hlink *find (long, long); //find the obj in hash table 
-  zgt_hlink *findt (long, long, long); //find the tx obj belongs to
-  int add ( zgt_tx *, long, long, char); //add an obj for a tx to hash table
-  int remove ( zgt_tx *, long, long);  //remove a lock entry
+  int lock ( zgt_tx *, long, long, char, zgt_hlink **); //grant or queue a request
+  int remove ( zgt_tx *, long, long);  //remove a lock entry; grants waiters
+  int drop ( zgt_hlink *);             //remove this granted entry; grants waiters
+  int cancel ( zgt_tx *, zgt_hlink *); //withdraw a queued request
+  int expire ();                       //abort the waits past their deadline
+  int resize (int);                    //rehash into a larger bucket array
   void print_ht();
   
   /*  constructors & destructors  */
@@ -97,16 +178,26 @@ class zgt_ht
   
  private:
   
-  int  mask;
-  int size;	
-  int hashing(long sgno, long obno)
-    {return((++sgno)*obno)&mask;}
+  zgt_stripes<zgt_hlink> table;
+
+  zgt_hbucket *lock_bucket(long sgno, long obno)
+    {return (table.lock(hashing(sgno, obno)));}
+  void unlock_bucket(zgt_hbucket *b)
+    {table.unlock(b);}
+  void grant_waiters(zgt_hbucket *, long, long, zgt_tx *);
+  void check_load(int, int);           //resize if the table is too loaded
+  void wound(zgt_tx *, char);
+  static void expire_bucket(zgt_hbucket *, int, void *);
+  void jumped(zgt_hlink *);
+  static unsigned long hashing(long sgno, long obno)
+    {
+      unsigned long k = (unsigned long)sgno * 0x9E3779B97F4A7C15UL ^ (unsigned long)obno;
+      k ^= k >> 29;
+      k *= 0xBF58476D1CE4E5B9UL;
+      k ^= k >> 32;
+      return(k);
+    }
+  static unsigned long entry_key(const zgt_hlink *h)
+    {return (hashing(h->sgno, h->obno));}
 
 };
-
-
-
-
-
-
-